@@ -0,0 +1,144 @@
+#ifndef REGISTER_MAP_HPP_
+#define REGISTER_MAP_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+
+struct mb_config {
+	int nb_input_registers{0};
+	int input_register_start{0};
+	std::string mb_protocol{"tcp"};
+	double mb_timeout{1.0};
+	int mb_update_time{1000};
+	std::string mb_tcp_target;
+	int mb_tcp_port{502};
+	int function_code{3};
+
+	std::string mb_rtu_serialport{"/dev/ttyS1"};
+	int mb_rtu_baud{9600};
+	char mb_rtu_parity{'N'};
+	int mb_rtu_databits{8};
+	int mb_rtu_stopbits{1};
+
+	int mb_slave{1};
+
+	int batch_size{1};
+	int batch_time{0};
+};
+
+// NOLINTBEGIN
+enum order_t { order_abcd, order_cdab, order_badc, order_dcba, order_invalid = -1 };
+NLOHMANN_JSON_SERIALIZE_ENUM(order_t, {
+	{order_invalid, nullptr},
+	{order_abcd, "abcd"},
+	{order_cdab, "cdab"},
+	{order_badc, "badc"},
+	{order_dcba, "dcba"},
+})
+
+enum register_type_t { type_i16, type_u16, type_i32, type_u32, type_i64, type_u64, type_f32, type_invalid = -1 };
+NLOHMANN_JSON_SERIALIZE_ENUM(register_type_t, {
+	{type_invalid, nullptr},
+	{type_i16, "i16"},
+	{type_u16, "u16"},
+	{type_i32, "i32"},
+	{type_u32, "u32"},
+	{type_i64, "i64"},
+	{type_u64, "u64"},
+	{type_f32, "f32"},
+})
+// NOLINTEND
+
+/*
+ * payloads of one source, built once and updated in place every tick:
+ * {"name": ..., "data": {"<identifier>": value, ...}}
+ * {"name": ..., "data": {"timestamps": [t0, t1, ...], "<identifier>": [v0, v1, ...], ...}}
+ */
+struct source_data {
+	nlohmann::json payload;
+	nlohmann::json batch;
+	nlohmann::json *data{nullptr};
+	nlohmann::json *timestamps{nullptr};
+	std::size_t samples{0};
+};
+
+/*
+ * a single map entry, decoded from the configuration at startup
+ */
+struct map_entry {
+	std::size_t source{0};
+	std::string identifier;
+	register_type_t type{type_invalid};
+	order_t order{order_abcd};
+	int address{0};
+	std::optional<double> scale;
+	std::optional<std::array<int, 4>> interpolation;
+	nlohmann::json *value{nullptr};
+	nlohmann::json *column{nullptr};
+};
+
+/*
+ * one coalesced read of a connection, covering the registers of one or more maps
+ */
+struct read_block {
+	int slave{1};
+	int function_code{3};
+	int start{0};
+	int count{0};
+	std::vector<uint16_t> reg;
+};
+
+/*
+ * a single configuration file
+ */
+struct mb_map {
+	std::string path;
+	mb_config configuration;
+	std::vector<map_entry> entries;
+	std::vector<source_data> sources;
+	std::size_t batch_capacity{0};
+	std::size_t block{0};
+	int divider{1};
+};
+
+auto getValueU16(const uint16_t* start, uint16_t offset) -> uint16_t;
+auto getValueI16(const uint16_t* start, uint16_t offset) -> int16_t;
+auto getValueU32(const uint16_t* start, uint16_t offset) -> uint32_t;
+auto getValueI32(const uint16_t* start, uint16_t offset) -> int32_t;
+auto getValueU64(const uint16_t* start, uint16_t offset) -> uint64_t;
+auto getValueI64(const uint16_t* start, uint16_t offset) -> int64_t;
+auto getValueF32(const uint16_t* start, uint16_t offset, order_t order) -> float;
+
+template<typename NumericType = uint16_t>
+auto interpolate(double from, double to, double value, NumericType int_from, NumericType int_to) -> NumericType {
+	return static_cast<NumericType>(
+		static_cast<double>(int_from) *
+		((1 - (value - from) / (to - from)) + static_cast<double>(int_to) * ((value - from) / (to - from))));
+}
+
+auto isBatchingEnabled(const mb_config& configuration) -> bool;
+
+/*
+ * decode the map of a configuration file and reserve all payloads and batch columns
+ */
+auto parseMapEntries(const nlohmann::json& mb_configuration, mb_map& m) -> void;
+
+/*
+ * decode the registers of a block into the payloads, failed values are set to null
+ */
+auto updateAttributeData(mb_map& m, const read_block& block) -> void;
+
+/*
+ * only valid with batching enabled, the batch payloads are not built otherwise
+ */
+auto appendToBatch(mb_map& m, int64_t timestamp) -> void;
+auto clearBatch(source_data& source) -> void;
+auto isBatchDue(const source_data& source, const mb_config& configuration) -> bool;
+
+#endif /* REGISTER_MAP_HPP_ */
@@ -7,10 +7,12 @@
 
 #include <getopt.h>
 #include <modbus.h>
+#include <sys/mman.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cerrno>
 #include <chrono>
 #include <cstdint>
@@ -20,17 +22,23 @@
 #include <exception>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <numeric>
 #include <ranges>
+#include <sstream>
 #include <string>
+#include <tuple>
 #include <unordered_set>
 #include <vector>
 
+#include "bemos_modbus_client/register_map.hpp"
 #include "bemos_modbus_client/version.hpp"
 #include "cxxopts.hpp"
 #include "nlohmann/json.hpp"
 #include "spdlog/async.h"
 #include "spdlog/fmt/bin_to_hex.h"
+#include "spdlog/fmt/ranges.h"
 #include "spdlog/sinks/daily_file_sink.h"
 #include "spdlog/sinks/stdout_color_sinks.h"
 #include "spdlog/spdlog.h"
@@ -39,6 +47,10 @@
 #include "spdlog/sinks/systemd_sink.h"
 #endif
 
+#ifndef LOG_QUEUE_SIZE
+#define LOG_QUEUE_SIZE 8192
+#endif
+
 #include "bone_helper/customTypeTraits.hpp"
 #include "bone_helper/jsonHelper.hpp"
 #include "bone_helper/loopTimer.hpp"
@@ -55,24 +67,19 @@ namespace {
 								"8f30276b3275fdbb8c60dea4a042c490"
 								"d73168d41cf70f9cdc3e1e62eb43f8e4";
 
-	struct mb_config {
-		int nb_input_registers{0};
-		int input_register_start{0};
-		std::string mb_protocol{"tcp"};
-		double mb_timeout{1.0};
-		int mb_update_time{1000};
-		std::string mb_tcp_target;
-		int mb_tcp_port{502};
-		int function_code{3};
-		
-		std::string mb_rtu_serialport{"/dev/ttyS1"};
-		int mb_rtu_baud{9600};
-		char mb_rtu_parity{'N'};
-		int mb_rtu_databits{8};
-		int mb_rtu_stopbits{1};
+	// lower bound for the common loop interval of multiple configuration files
+	constexpr int min_loop_interval = 50;
 
-		int mb_slave{1};
-	};
+	// minimum time between reconnect attempts of a failed connection in ms
+	constexpr int reconnect_interval = 10000;
+
+	auto getEndpoint(const mb_config& configuration) -> std::string {
+		if (configuration.mb_protocol == "tcp") {
+			return fmt::format("tcp://{}:{}", configuration.mb_tcp_target, configuration.mb_tcp_port);
+		}
+
+		return fmt::format("rtu://{}", configuration.mb_rtu_serialport);
+	}
 
 	auto initializeModbusContext(const mb_config& configuration) -> modbus_t* {
 		modbus_t *ctx = nullptr;
@@ -149,6 +156,16 @@ namespace {
 		configuration.function_code = value_ig_type(mb_configuration, "function", configuration.function_code);
 		configuration.mb_update_time = value_ig_type(mb_configuration, "update_time", configuration.mb_update_time);
 		configuration.mb_slave = value_ig_type(mb_configuration, "slave id", configuration.mb_slave);
+		configuration.batch_size = value_ig_type(mb_configuration, "batch_size", configuration.batch_size);
+		configuration.batch_time = value_ig_type(mb_configuration, "batch_time", configuration.batch_time);
+
+		if (configuration.mb_update_time <= 0) {
+			throw std::runtime_error("invalid update time");
+		}
+
+		if (configuration.batch_size < 1 || configuration.batch_time < 0) {
+			throw std::runtime_error("invalid batch configuration");
+		}
 
 		if (configuration.mb_protocol == "tcp") {
 			configuration.mb_tcp_target = mb_configuration.at("server_address").get<std::string>();
@@ -230,190 +247,205 @@ namespace {
 		return configuration;
 	}
 
-	// NOLINTBEGIN
-	enum order_t { order_abcd, order_cdab, order_badc, order_dcba, order_invalid = -1 };
-	NLOHMANN_JSON_SERIALIZE_ENUM(order_t, {
-		{order_invalid, nullptr},
-		{order_abcd, "abcd"},
-		{order_cdab, "cdab"},
-		{order_badc, "badc"},
-		{order_dcba, "dcba"},
-	})
-
-	enum register_type_t { type_i16, type_u16, type_i32, type_u32, type_i64, type_u64, type_f32, type_invalid = -1 };
-	NLOHMANN_JSON_SERIALIZE_ENUM(register_type_t, {
-		{type_invalid, nullptr},
-		{type_i16, "i16"},
-		{type_u16, "u16"},
-		{type_i32, "i32"},
-		{type_u32, "u32"},
-		{type_i64, "i64"},
-		{type_u64, "u64"},
-		{type_f32, "f32"},
-	})
-	// NOLINTEND
-
-	auto getValueU16(const uint16_t* start, uint16_t offset) -> uint16_t {
-		if (start == nullptr) {
-			throw std::invalid_argument("out of bounds");
-		}
-
-		return start[offset];
-	}
-
-	auto getValueI16(const uint16_t* start, uint16_t offset) -> int16_t {
-		uint16_t ival = getValueU16(start, offset);
+	/*
+	 * a single Modbus session shared by all maps configured for the same endpoint
+	 */
+	struct mb_connection {
+		mb_config configuration;
+		modbus_t *ctx{nullptr};
+		std::vector<std::size_t> maps;
+		std::vector<read_block> blocks;
+		bool connected{true};
+		uint64_t retry_tick{0};
+	};
 
-		int16_t val = 0;
-		std::memcpy(&val, &ival, sizeof(val));
-		
-		return val;
-	}
+	/*
+	 * merge the register ranges of all maps sharing a connection into as few reads as possible;
+	 * only overlapping or adjacent ranges are merged to not read registers the device may not provide
+	 */
+	auto buildReadPlan(mb_connection& connection, std::vector<mb_map>& maps) -> void {
+		auto order = connection.maps;
 
-	auto getValueU32(const uint16_t* start, uint16_t offset) -> uint32_t {
-		uint32_t val = getValueU16(start, offset);
-		return (val << 16u) + getValueU16(start, offset + 1);
-	}
+		std::ranges::sort(order, [&maps](std::size_t a, std::size_t b) {
+			const auto& lhs = maps.at(a).configuration;
+			const auto& rhs = maps.at(b).configuration;
 
+			return std::tie(lhs.mb_slave, lhs.function_code, lhs.input_register_start) <
+				   std::tie(rhs.mb_slave, rhs.function_code, rhs.input_register_start);
+		});
 
-	auto getValueI32(const uint16_t* start, uint16_t offset) -> int32_t {
-		uint32_t ival = getValueU32(start, offset);
-		
-		int32_t val = 0;
-		std::memcpy(&val, &ival, sizeof(val));
+		connection.blocks.clear();
 
-		return val;
-	}
+		for (const auto i : order) {
+			auto& e = maps.at(i);
+			const auto& configuration = e.configuration;
+			const auto end = configuration.input_register_start + configuration.nb_input_registers;
 
-	auto getValueU64(const uint16_t* start, uint16_t offset) -> uint64_t {
-		const uint64_t val = getValueU32(start, offset);
-		return (val << 32u) + getValueU32(start, offset + 2);
-	}
+			if (!connection.blocks.empty()) {
+				auto& block = connection.blocks.back();
 
+				if (block.slave == configuration.mb_slave && block.function_code == configuration.function_code &&
+					configuration.input_register_start <= block.start + block.count &&
+					std::max(end, block.start + block.count) - block.start <= MODBUS_MAX_READ_REGISTERS) {
+					block.count = std::max(end, block.start + block.count) - block.start;
+					e.block = connection.blocks.size() - 1;
+					continue;
+				}
+			}
 
-	auto getValueI64(const uint16_t* start, uint16_t offset) -> int64_t {
-		uint64_t ival = getValueU64(start, offset);
-		
-		int64_t val = 0;
-		std::memcpy(&val, &ival, sizeof(val));
+			connection.blocks.push_back({configuration.mb_slave, configuration.function_code,
+										 configuration.input_register_start, configuration.nb_input_registers, {}});
+			e.block = connection.blocks.size() - 1;
+		}
 
-		return val;
+		for (auto& block : connection.blocks) {
+			block.reg.resize(static_cast<std::size_t>(block.count));
+			spdlog::debug("{}: reading {} registers of slave {} starting at {}", getEndpoint(connection.configuration),
+						  block.count, block.slave, block.start);
+		}
 	}
 
-	auto getValueF32(const uint16_t* start, uint16_t offset, const order_t order) -> float {
-		if (start == nullptr) {
-			throw std::invalid_argument("out of bounds");
-		}
+	auto reconnectModbusContext(mb_connection& connection) -> bool {
+		const auto endpoint = getEndpoint(connection.configuration);
 
-		switch (order) {
-		default:
-			throw std::invalid_argument("unknown byte order");
-		case order_abcd:
-			return modbus_get_float_abcd(start + offset);
-		case order_cdab:
-			return modbus_get_float_cdab(start + offset);
-		case order_badc:
-			return modbus_get_float_badc(start + offset);
-		case order_dcba:
-			return modbus_get_float_dcba(start + offset);
+		if (modbus_connect(connection.ctx) == -1) {
+			spdlog::error("{}: reconnect failed: {}", endpoint, modbus_strerror(errno));
+			return false;
 		}
-	}
 
-	template<typename NumericType = uint16_t>
-	auto interpolate(double from, double to, double value, NumericType int_from, NumericType int_to) -> NumericType {
-		return static_cast<NumericType>(
-			static_cast<double>(int_from) *
-			((1 - (value - from) / (to - from)) + static_cast<double>(int_to) * ((value - from) / (to - from))));
+		spdlog::info("{}: reconnected", endpoint);
+		return true;
 	}
 
-	auto readRegisters(modbus_t* ctx, std::vector<uint16_t>& reg, const mb_config& configuration) -> int {
+	auto readRegisters(modbus_t* ctx, read_block& block) -> int {
 		int retval = 0;
 
-		if (configuration.nb_input_registers == 0) {
+		if (block.count == 0) {
 			throw std::runtime_error("no input registers to read");
-			return 0;
 		}
 
-		if (configuration.function_code == 4) {
-			retval = modbus_read_input_registers(ctx, configuration.input_register_start,
-												 configuration.nb_input_registers, reg.data());
+		/*
+		 * blocks of different slaves share the same context
+		 */
+		if (modbus_set_slave(ctx, block.slave) != 0) {
+			throw std::runtime_error(fmt::format("could not set slave address to {}", block.slave));
+		}
+
+		if (block.function_code == 4) {
+			retval = modbus_read_input_registers(ctx, block.start, block.count, block.reg.data());
 		} else {
-			retval = modbus_read_registers(ctx, configuration.input_register_start,
-										   configuration.nb_input_registers, reg.data());
+			retval = modbus_read_registers(ctx, block.start, block.count, block.reg.data());
 		}
 
 		if (retval == -1) {
-			throw std::runtime_error(fmt::format("error reading registers, exiting: {}", modbus_strerror(errno)));
+			throw std::runtime_error(fmt::format("error reading registers: {}", modbus_strerror(errno)));
 		}
 
 		return retval;
 	}
 
-	auto getAttributeData(const json& map, const std::vector<uint16_t>& reg, const mb_config& configuration) -> json {
-		json attribute_data;
+	auto sendData(bestsens::netHelper& socket, const json& payload) -> void {
+		json k;
 
-		for (const auto& e : map) {
-			try {
-				const auto source = e.at("source").get<std::string>();
-				const auto identifier = e.at("identifier").get<std::string>();
-				const auto register_type = e.at("type").get<register_type_t>();
-				const auto address =
-					coerceCast<uint16_t>(e.at("address").get<int>() - configuration.input_register_start);
+		if (socket.send_command("new_data", k, payload) == 0) {
+			spdlog::error("error updating algorithm_config");
+		}
+	}
 
-				const auto order = [&e]() -> order_t {
-					try {
-						return e.at("order").get<order_t>();
-					} catch (...) {}  // NOLINT(bugprone-empty-catch)
+	auto publishData(bestsens::netHelper& socket, mb_map& m, int64_t timestamp) -> void {
+		if (!isBatchingEnabled(m.configuration)) {
+			for (const auto& source : m.sources) {
+				const auto& data = source.payload.at("data");
+				const auto is_valid = [](const json& e) { return !e.is_null(); };
+
+				if (std::ranges::all_of(data, is_valid)) {
+					sendData(socket, source.payload);
+				} else if (std::ranges::any_of(data, is_valid)) {
+					// leave out identifiers that failed to decode
+					json payload = {{"name", source.payload.at("name")}, {"data", json::object()}};
+
+					for (const auto& e : data.items()) {
+						if (is_valid(e.value())) {
+							payload["data"][e.key()] = e.value();
+						}
+					}
 
-					return order_abcd;
-				}();
+					sendData(socket, payload);
+				}
+			}
 
-				double value{};
+			return;
+		}
 
-				switch (register_type) {
-					case type_f32:	value = static_cast<double>(getValueF32(reg.data(), address, order)); break;
-					case type_i16:	value = static_cast<double>(getValueI16(reg.data(), address)); break;
-					case type_u16:	value = static_cast<double>(getValueU16(reg.data(), address)); break;
-					case type_i32:	value = static_cast<double>(getValueI32(reg.data(), address)); break;
-					case type_u32:	value = static_cast<double>(getValueU32(reg.data(), address)); break;
-					case type_i64:	value = static_cast<double>(getValueI64(reg.data(), address)); break;
-					case type_u64:	value = static_cast<double>(getValueU64(reg.data(), address)); break;
-					default: throw std::invalid_argument("register type not available"); break;
-				}
+		appendToBatch(m, timestamp);
 
-				try {
-					if (e.at("scale").is_number()) {
-						value *= e.at("scale").get<double>();
-					} else if (e.at("scale").is_array()) {
-						auto scale = e.at("scale").get<std::array<int, 4>>();
-						value = interpolate(scale.at(0), scale.at(1), value, scale.at(2), scale.at(3));
-					}
-				} catch (...) {}  // NOLINT(bugprone-empty-catch)
+		for (auto& source : m.sources) {
+			if (isBatchDue(source, m.configuration)) {
+				spdlog::trace("sending {} samples of {}", source.samples, source.batch.at("name").get_ref<const std::string&>());
+				sendData(socket, source.batch);
+				clearBatch(source);
+			}
+		}
+	}
 
-				attribute_data[source][identifier] = value;
-			} catch (const std::exception& err) {
-				spdlog::error("error getting value: {}", err.what());
+	/*
+	 * resident and locked memory as reported by the kernel
+	 */
+	auto readMemoryStatus() -> std::string {
+		std::ifstream file("/proc/self/status");
+		std::string line;
+		std::vector<std::string> values;
+
+		while (std::getline(file, line)) {
+			if (line.starts_with("VmRSS:") || line.starts_with("VmLck:")) {
+				std::istringstream stream(line);
+				std::string key;
+				std::string value;
+				std::string unit;
+
+				stream >> key >> value >> unit;
+				values.push_back(fmt::format("{} {} {}", key, value, unit));
 			}
 		}
 
-		return attribute_data;
+		if (values.empty()) {
+			return "not available";
+		}
+
+		return fmt::format("{}", fmt::join(values, ", "));
 	}
 
 	auto initializeSpdlog(const std::string& application_name) {
-		spdlog::init_thread_pool(8192, 1);
+		#if LOG_QUEUE_SIZE > 0
+		spdlog::init_thread_pool(LOG_QUEUE_SIZE, 1);
+		using log_factory = spdlog::async_factory;
+		#else
+		using log_factory = spdlog::synchronous_factory;
+		#endif
 
-		auto console = spdlog::stdout_color_mt<spdlog::async_factory>("console");
+		auto console = spdlog::stdout_color_mt<log_factory>("console");
 		console->set_pattern("%v");
 
 		#ifdef ENABLE_SYSTEMD_STATUS
 		auto create_systemd_logger = [](std::string name) {
 			std::vector<spdlog::sink_ptr> sinks;
+
+			#if LOG_QUEUE_SIZE > 0
 			sinks.push_back(std::make_shared<spdlog::sinks::stdout_color_sink_st>());
 			sinks.push_back(std::make_shared<spdlog::sinks::systemd_sink_st>());
+			#else
+			// without the pool worker the sinks are also flushed from the flush_every thread
+			sinks.push_back(std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
+			sinks.push_back(std::make_shared<spdlog::sinks::systemd_sink_mt>());
+			#endif
 
 			sinks[1]->set_pattern("%v");
 
+			#if LOG_QUEUE_SIZE > 0
 			auto logger = std::make_shared<spdlog::async_logger>(name, begin(sinks), end(sinks), spdlog::thread_pool(), spdlog::async_overflow_policy::overrun_oldest);
+			#else
+			auto logger = std::make_shared<spdlog::logger>(name, begin(sinks), end(sinks));
+			#endif
 			spdlog::register_logger(logger);
 			return logger;
 		};
@@ -423,7 +455,7 @@ namespace {
 		spdlog::set_default_logger(systemd_logger);
 		auto default_logger = systemd_logger;
 		#else
-		auto stdout_logger = spdlog::stdout_color_mt<spdlog::async_factory>(application_name);
+		auto stdout_logger = spdlog::stdout_color_mt<log_factory>(application_name);
 		stdout_logger->flush_on(spdlog::level::err); 
 		spdlog::set_default_logger(stdout_logger);
 		auto default_logger = stdout_logger;
@@ -438,13 +470,14 @@ namespace {
 auto main(int argc, char **argv) -> int {
 	bool daemon = false;
 	bool skip_bemos = false;
+	bool lock_memory = false;
 
 	auto default_logger = initializeSpdlog("bemos_modbus_client");
 
 	std::string conn_target = "localhost";
 	std::string conn_port = "6450";
 
-	std::string config_path;
+	std::vector<std::string> config_paths;
 
 	std::string username = std::string(login_user);
 	std::string password = std::string(login_hash);
@@ -465,8 +498,9 @@ auto main(int argc, char **argv) -> int {
 			("username", "username used to connect", cxxopts::value<std::string>(username)->default_value(std::string(login_user)))
 			("password", "plain text password used to connect", cxxopts::value<std::string>())
 			("suppress_syslog", "do not output syslog messages to stdout")
-			("config", "path to configuration file", cxxopts::value<std::string>(), "FILE")
+			("config", "path to configuration file, maps of the same device share one connection", cxxopts::value<std::vector<std::string>>(), "FILE")
 			("skip_bemos", "do not use bemos", cxxopts::value<bool>(skip_bemos))
+			("mlockall", "lock all memory after startup", cxxopts::value<bool>(lock_memory))
 		;
 
 		try {
@@ -509,8 +543,11 @@ auto main(int argc, char **argv) -> int {
 			}
 
 			if (result.count("config") != 0u) {
-				config_path = result["config"].as<std::string>();
-				spdlog::info("using configuration file: {}", config_path);
+				config_paths = result["config"].as<std::vector<std::string>>();
+
+				for (const auto& e : config_paths) {
+					spdlog::info("using configuration file: {}", e);
+				}
 			}
 
 			if (result.count("verbose") != 0u) {
@@ -538,7 +575,7 @@ auto main(int argc, char **argv) -> int {
 
 	spdlog::info("starting bemos-modbus-client {}", appVersion());
 
-	if (config_path.empty()) {
+	if (config_paths.empty()) {
 		spdlog::error("configuration path not set");
 		return EXIT_FAILURE;
 	}
@@ -575,17 +612,120 @@ auto main(int argc, char **argv) -> int {
 	}
 
 	/*
-	 * read configuration file
+	 * read configuration files
 	 */
-	spdlog::debug("opening configuration file...");
-	const auto mb_configuration = loadConfigurationFile(config_path);
-	
-	spdlog::debug("parsing configuration file...");
-	const auto configuration = parseConfigurationFile(mb_configuration, socket);
-	spdlog::debug("finished parsing configuration file");
+	std::vector<mb_map> maps;
+	maps.reserve(config_paths.size());
+
+	for (const auto& path : config_paths) {
+		spdlog::debug("opening configuration file {}...", path);
+		const auto mb_configuration = loadConfigurationFile(path);
+
+		spdlog::debug("parsing configuration file {}...", path);
+		auto& m = maps.emplace_back();
+		m.path = path;
+		m.configuration = parseConfigurationFile(mb_configuration, socket);
+		parseMapEntries(mb_configuration, m);
+
+		if (isBatchingEnabled(m.configuration)) {
+			spdlog::info("{}: batching up to {} samples / {} ms per source", path, m.configuration.batch_size,
+						 m.configuration.batch_time);
+		}
+	}
 
-	std::vector<uint16_t> reg(configuration.nb_input_registers);
-	auto *ctx = initializeModbusContext(configuration);
+	spdlog::debug("finished parsing configuration files");
+
+	/*
+	 * group maps by endpoint
+	 */
+	std::vector<mb_connection> connections;
+
+	for (std::size_t i = 0; i < maps.size(); ++i) {
+		const auto& configuration = maps.at(i).configuration;
+		const auto endpoint = getEndpoint(configuration);
+
+		auto it = std::ranges::find_if(connections, [&endpoint](const mb_connection& e) {
+			return getEndpoint(e.configuration) == endpoint;
+		});
+
+		if (it == connections.end()) {
+			connections.push_back({configuration, nullptr, {}, {}});
+			it = std::prev(connections.end());
+		} else if (configuration.mb_protocol == "rtu" &&
+				   (configuration.mb_rtu_baud != it->configuration.mb_rtu_baud ||
+					configuration.mb_rtu_parity != it->configuration.mb_rtu_parity ||
+					configuration.mb_rtu_databits != it->configuration.mb_rtu_databits ||
+					configuration.mb_rtu_stopbits != it->configuration.mb_rtu_stopbits)) {
+			spdlog::critical("{}: serial settings differ from other maps on {}", maps.at(i).path, endpoint);
+			return EXIT_FAILURE;
+		} else if (configuration.mb_timeout != it->configuration.mb_timeout) {
+			spdlog::critical("{}: timeout differs from other maps on {}", maps.at(i).path, endpoint);
+			return EXIT_FAILURE;
+		}
+
+		// would fail every read of the shared connection
+		if (configuration.nb_input_registers == 0) {
+			spdlog::critical("{}: no input registers to read", maps.at(i).path);
+			return EXIT_FAILURE;
+		}
+
+		it->maps.push_back(i);
+	}
+
+	for (auto& e : connections) {
+		buildReadPlan(e, maps);
+		e.ctx = initializeModbusContext(e.configuration);
+	}
+
+	/*
+	 * run the loop with the greatest common interval of all maps
+	 */
+	int update_time = 0;
+
+	int min_update_time = std::numeric_limits<int>::max();
+
+	for (const auto& e : maps) {
+		update_time = std::gcd(update_time, e.configuration.mb_update_time);
+		min_update_time = std::min(min_update_time, e.configuration.mb_update_time);
+	}
+
+	/*
+	 * e.g. 1000 ms and 1001 ms would wake the loop every millisecond
+	 */
+	if (update_time < min_update_time && update_time < min_loop_interval) {
+		spdlog::critical("update times of the configuration files share no common interval of at least {} ms",
+						 min_loop_interval);
+		return EXIT_FAILURE;
+	}
+
+	for (auto& e : maps) {
+		e.divider = e.configuration.mb_update_time / update_time;
+	}
+
+	const auto reconnect_ticks = static_cast<uint64_t>(std::max(1, reconnect_interval / update_time));
+
+	/*
+	 * estimate memory reserved for the loop, identifier strings and json nodes are not included
+	 */
+	{
+		std::size_t register_bytes = 0;
+		std::size_t entry_bytes = 0;
+		std::size_t batch_bytes = 0;
+
+		for (const auto& e : connections) {
+			for (const auto& block : e.blocks) {
+				register_bytes += block.reg.capacity() * sizeof(uint16_t);
+			}
+		}
+
+		for (const auto& e : maps) {
+			entry_bytes += e.entries.capacity() * sizeof(map_entry) + e.sources.capacity() * sizeof(source_data);
+			batch_bytes += (e.entries.size() + e.sources.size()) * e.batch_capacity * sizeof(json);
+		}
+
+		spdlog::info("estimated reserved memory: {} B registers, {} B map, {} B batches, {} B log queue", register_bytes,
+					 entry_bytes, batch_bytes, LOG_QUEUE_SIZE * sizeof(spdlog::details::async_msg));
+	}
 
 	/* Deamonize */
 	if (daemon) {
@@ -595,40 +735,109 @@ auto main(int argc, char **argv) -> int {
 		spdlog::debug("skipped daemonizing");
 	}
 
-	bestsens::loopTimer timer(std::chrono::milliseconds(configuration.mb_update_time), false);
+	/*
+	 * memory locks are not inherited by the daemonized child
+	 */
+	if (lock_memory) {
+		if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+			spdlog::warn("could not lock memory: {}", std::strerror(errno));
+		} else {
+			spdlog::info("memory locked");
+		}
+	}
+
+	bestsens::loopTimer timer(std::chrono::milliseconds(update_time), false);
 
 	bestsens::system_helper::systemd::ready();
 
-	while (true) {
+	/*
+	 * every map has sent at least one full batch once this tick is reached
+	 */
+	uint64_t warmup_ticks = 0;
+
+	for (const auto& e : maps) {
+		warmup_ticks = std::max(warmup_ticks, static_cast<uint64_t>(e.divider) * std::max<uint64_t>(e.batch_capacity, 1));
+	}
+
+	for (uint64_t tick = 0; true; ++tick) {
 		bestsens::system_helper::systemd::watchdog();
 		timer.wait_on_tick();
 
-		readRegisters(ctx, reg, configuration);
+		if (tick == warmup_ticks) {
+			spdlog::info("memory after warm-up: {}", readMemoryStatus());
+		}
+
+		const auto isDue = [tick](const mb_map& e) -> bool {
+			return tick % static_cast<uint64_t>(e.divider) == 0;
+		};
 
-		const auto& map = mb_configuration.at("map");
-		const auto attribute_data = getAttributeData(map, reg, configuration);
+		for (auto& connection : connections) {
+			/*
+			 * a failed connection is skipped and only retried every reconnect_interval; all connections are
+			 * polled sequentially, so a dead device still delays the others by one response timeout on failure
+			 * and by one connect attempt per retry
+			 */
+			if (!connection.connected) {
+				if (tick < connection.retry_tick) {
+					continue;
+				}
 
-		if (socket != nullptr) {
-			for (const auto &e : attribute_data.items()) {
-				if (!e.value().is_null()) {
-					json k;
-					const json payload = {
-						{"name", e.key()},
-						{"data", e.value()}
-					};
-
-					if (socket->send_command("new_data", k, payload) == 0) {
-						spdlog::error("error updating algorithm_config");
+				connection.connected = reconnectModbusContext(connection);
+
+				if (!connection.connected) {
+					connection.retry_tick = tick + reconnect_ticks;
+					continue;
+				}
+			}
+
+			try {
+				for (std::size_t i = 0; i < connection.blocks.size(); ++i) {
+					const auto block_due = std::ranges::any_of(connection.maps, [&](std::size_t k) {
+						return maps.at(k).block == i && isDue(maps.at(k));
+					});
+
+					if (block_due) {
+						readRegisters(connection.ctx, connection.blocks.at(i));
 					}
 				}
+			} catch (const std::exception& err) {
+				spdlog::error("{}: {}", getEndpoint(connection.configuration), err.what());
+				modbus_close(connection.ctx);
+				connection.connected = false;
+				connection.retry_tick = tick + reconnect_ticks;
+				continue;
 			}
-		}
 
-		spdlog::debug("{}", attribute_data.dump(2));
+			const auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+									   std::chrono::system_clock::now().time_since_epoch())
+									   .count();
+
+			for (const auto k : connection.maps) {
+				auto& e = maps.at(k);
+
+				if (!isDue(e)) {
+					continue;
+				}
+
+				updateAttributeData(e, connection.blocks.at(e.block));
+
+				if (socket != nullptr) {
+					publishData(*socket, e, timestamp);
+				}
+
+				if (spdlog::should_log(spdlog::level::debug)) {
+					for (const auto& source : e.sources) {
+						spdlog::debug("{}", source.payload.dump(2));
+					}
+				}
+			}
+		}
 	}
 
-	modbus_close(ctx);
-	modbus_free(ctx);
+	for (auto& e : connections) {
+		modbus_close(e.ctx);
+		modbus_free(e.ctx);
+	}
 
 	spdlog::debug("exited");
 
@@ -0,0 +1,266 @@
+/*
+ * register_map.cpp
+ *
+ *  Created on: 18.10.2026
+ */
+
+#include "bemos_modbus_client/register_map.hpp"
+
+#include <modbus.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+
+#include "bone_helper/customTypeTraits.hpp"
+#include "spdlog/spdlog.h"
+
+using json = nlohmann::json;
+
+auto getValueU16(const uint16_t* start, uint16_t offset) -> uint16_t {
+	if (start == nullptr) {
+		throw std::invalid_argument("out of bounds");
+	}
+
+	return start[offset];
+}
+
+auto getValueI16(const uint16_t* start, uint16_t offset) -> int16_t {
+	uint16_t ival = getValueU16(start, offset);
+
+	int16_t val = 0;
+	std::memcpy(&val, &ival, sizeof(val));
+	
+	return val;
+}
+
+auto getValueU32(const uint16_t* start, uint16_t offset) -> uint32_t {
+	uint32_t val = getValueU16(start, offset);
+	return (val << 16u) + getValueU16(start, offset + 1);
+}
+
+
+auto getValueI32(const uint16_t* start, uint16_t offset) -> int32_t {
+	uint32_t ival = getValueU32(start, offset);
+	
+	int32_t val = 0;
+	std::memcpy(&val, &ival, sizeof(val));
+
+	return val;
+}
+
+auto getValueU64(const uint16_t* start, uint16_t offset) -> uint64_t {
+	const uint64_t val = getValueU32(start, offset);
+	return (val << 32u) + getValueU32(start, offset + 2);
+}
+
+
+auto getValueI64(const uint16_t* start, uint16_t offset) -> int64_t {
+	uint64_t ival = getValueU64(start, offset);
+	
+	int64_t val = 0;
+	std::memcpy(&val, &ival, sizeof(val));
+
+	return val;
+}
+
+auto getValueF32(const uint16_t* start, uint16_t offset, const order_t order) -> float {
+	if (start == nullptr) {
+		throw std::invalid_argument("out of bounds");
+	}
+
+	switch (order) {
+	default:
+		throw std::invalid_argument("unknown byte order");
+	case order_abcd:
+		return modbus_get_float_abcd(start + offset);
+	case order_cdab:
+		return modbus_get_float_cdab(start + offset);
+	case order_badc:
+		return modbus_get_float_badc(start + offset);
+	case order_dcba:
+		return modbus_get_float_dcba(start + offset);
+	}
+}
+
+auto isBatchingEnabled(const mb_config& configuration) -> bool {
+	return configuration.batch_size > 1 || configuration.batch_time > 0;
+}
+
+/*
+ * all json nodes used by the loop are created here, so updating, batching and clearing do not allocate
+ */
+auto parseMapEntries(const json& mb_configuration, mb_map& m) -> void {
+	const auto& configuration = m.configuration;
+	std::vector<std::string> source_names;
+
+	if (mb_configuration.contains("map") && mb_configuration.at("map").is_array()) {
+		for (const auto& e : mb_configuration.at("map")) {
+			if (e.is_null()) {
+				continue;
+			}
+
+			// would share its key with the timestamp column of the batch payload
+			if (isBatchingEnabled(configuration) && e.value("identifier", "") == "timestamps") {
+				throw std::runtime_error(fmt::format("{}: identifier \"timestamps\" is reserved for batching", m.path));
+			}
+
+			try {
+				map_entry entry;
+				const auto source = e.at("source").get<std::string>();
+				entry.identifier = e.at("identifier").get<std::string>();
+				entry.type = e.at("type").get<register_type_t>();
+				entry.address = e.at("address").get<int>();
+
+				if (entry.type == type_invalid) {
+					throw std::invalid_argument("register type not available");
+				}
+
+				try {
+					entry.order = e.at("order").get<order_t>();
+				} catch (...) {}  // NOLINT(bugprone-empty-catch)
+
+				if (e.contains("scale") && e.at("scale").is_number()) {
+					entry.scale = e.at("scale").get<double>();
+				} else if (e.contains("scale") && e.at("scale").is_array()) {
+					entry.interpolation = e.at("scale").get<std::array<int, 4>>();
+				}
+
+				const auto it = std::ranges::find(source_names, source);
+				entry.source = static_cast<std::size_t>(std::distance(source_names.begin(), it));
+
+				if (it == source_names.end()) {
+					source_names.push_back(source);
+				}
+
+				/*
+				 * the last entry of an identifier wins, each identifier gets exactly one column
+				 */
+				auto duplicate = std::ranges::find_if(m.entries, [&entry](const map_entry& f) {
+					return f.source == entry.source && f.identifier == entry.identifier;
+				});
+
+				if (duplicate != m.entries.end()) {
+					spdlog::warn("{}: duplicate identifier {} of source {}", m.path, entry.identifier, source);
+					*duplicate = std::move(entry);
+				} else {
+					m.entries.push_back(std::move(entry));
+				}
+			} catch (const std::exception& err) {
+				spdlog::error("{}: skipping map entry: {}", m.path, err.what());
+			}
+		}
+	}
+
+	/*
+	 * matches the sample count at which isBatchDue() fires
+	 */
+	if (isBatchingEnabled(configuration)) {
+		const auto time_samples =
+			(configuration.batch_time + configuration.mb_update_time - 1) / configuration.mb_update_time;
+		m.batch_capacity = static_cast<std::size_t>(std::max(configuration.batch_size, time_samples));
+	}
+
+	m.sources.resize(source_names.size());
+
+	/*
+	 * json objects are node based, pointers into them stay valid; the batch payloads and columns are only
+	 * built when batching is enabled, otherwise data, timestamps and column stay null
+	 */
+	const auto batching = isBatchingEnabled(configuration);
+
+	for (std::size_t i = 0; i < source_names.size(); ++i) {
+		auto& source = m.sources.at(i);
+		source.payload = {{"name", source_names.at(i)}, {"data", json::object()}};
+
+		if (batching) {
+			source.batch = {{"name", source_names.at(i)}, {"data", {{"timestamps", json::array()}}}};
+			source.data = &source.batch.at("data");
+			source.timestamps = &source.data->at("timestamps");
+			source.timestamps->get_ref<json::array_t&>().reserve(m.batch_capacity);
+		}
+	}
+
+	for (auto& entry : m.entries) {
+		auto& source = m.sources.at(entry.source);
+		entry.value = &source.payload.at("data")[entry.identifier];
+
+		if (batching) {
+			entry.column = &(*source.data)[entry.identifier];
+			*entry.column = json::array();
+			entry.column->get_ref<json::array_t&>().reserve(m.batch_capacity);
+		}
+	}
+}
+
+auto updateAttributeData(mb_map& m, const read_block& block) -> void {
+	for (auto& e : m.entries) {
+		try {
+			const auto address = bestsens::coerceCast<uint16_t>(e.address - block.start);
+			const auto *reg = block.reg.data();
+
+			double value{};
+
+			switch (e.type) {
+				case type_f32:	value = static_cast<double>(getValueF32(reg, address, e.order)); break;
+				case type_i16:	value = static_cast<double>(getValueI16(reg, address)); break;
+				case type_u16:	value = static_cast<double>(getValueU16(reg, address)); break;
+				case type_i32:	value = static_cast<double>(getValueI32(reg, address)); break;
+				case type_u32:	value = static_cast<double>(getValueU32(reg, address)); break;
+				case type_i64:	value = static_cast<double>(getValueI64(reg, address)); break;
+				case type_u64:	value = static_cast<double>(getValueU64(reg, address)); break;
+				default: throw std::invalid_argument("register type not available"); break;
+			}
+
+			if (e.scale) {
+				value *= *e.scale;
+			} else if (e.interpolation) {
+				const auto& scale = *e.interpolation;
+				value = interpolate(scale.at(0), scale.at(1), value, scale.at(2), scale.at(3));
+			}
+
+			*e.value = value;
+		} catch (const std::exception& err) {
+			*e.value = nullptr;
+			spdlog::error("error getting value: {}", err.what());
+		}
+	}
+}
+
+auto appendToBatch(mb_map& m, int64_t timestamp) -> void {
+	for (auto& source : m.sources) {
+		source.timestamps->push_back(timestamp);
+		++source.samples;
+	}
+
+	for (auto& e : m.entries) {
+		e.column->push_back(*e.value);
+	}
+}
+
+auto clearBatch(source_data& source) -> void {
+	// clear() keeps the reserved capacity of the columns
+	for (auto& e : *source.data) {
+		e.clear();
+	}
+
+	source.samples = 0;
+}
+
+auto isBatchDue(const source_data& source, const mb_config& configuration) -> bool {
+	if (source.samples == 0) {
+		return false;
+	}
+
+	if (configuration.batch_size > 1 && source.samples >= static_cast<std::size_t>(configuration.batch_size)) {
+		return true;
+	}
+
+	/*
+	 * counted in update intervals instead of wall time, so read jitter cannot add a sample beyond the capacity
+	 */
+	return configuration.batch_time > 0 &&
+		   source.samples * static_cast<std::size_t>(configuration.mb_update_time) >=
+			   static_cast<std::size_t>(configuration.batch_time);
+}
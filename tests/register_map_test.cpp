@@ -0,0 +1,232 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "bemos_modbus_client/register_map.hpp"
+#include "nlohmann/json.hpp"
+
+using json = nlohmann::json;
+
+namespace {
+	std::atomic<std::size_t> allocations{0};
+
+	auto createMap(const json& mb_configuration, int batch_size, int batch_time = 0) -> mb_map {
+		mb_map m;
+		m.path = "test.conf";
+		m.configuration.mb_update_time = 100;
+		m.configuration.batch_size = batch_size;
+		m.configuration.batch_time = batch_time;
+
+		parseMapEntries(mb_configuration, m);
+
+		return m;
+	}
+
+	auto createBlock() -> read_block {
+		read_block block{1, 3, 1, 8, {}};
+		block.reg = {42, 0x4148, 0x0000, 0xFFFF, 0xFF9C, 0, 0, 0};
+
+		return block;
+	}
+
+	/*
+	 * one tick of the main loop in batched mode
+	 */
+	auto tick(mb_map& m, const read_block& block, int64_t timestamp) -> void {
+		updateAttributeData(m, block);
+		appendToBatch(m, timestamp);
+
+		for (auto& source : m.sources) {
+			if (isBatchDue(source, m.configuration)) {
+				clearBatch(source);
+			}
+		}
+	}
+
+	const json test_configuration = {
+		{"map", {
+			{{"source", "a"}, {"identifier", "x"}, {"address", 1}, {"type", "u16"}},
+			{{"source", "a"}, {"identifier", "y"}, {"address", 2}, {"type", "f32"}, {"order", "abcd"}},
+			{{"source", "b"}, {"identifier", "z"}, {"address", 4}, {"type", "i32"}, {"scale", 0.1}},
+		}}
+	};
+}  // namespace
+
+// NOLINTBEGIN
+auto operator new(std::size_t size) -> void* {
+	++allocations;
+
+	if (void* ptr = std::malloc(size != 0 ? size : 1)) {
+		return ptr;
+	}
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept {
+	std::free(ptr);
+}
+// NOLINTEND
+
+TEST_CASE("register map decoding", "[register_map]") {
+	auto m = createMap(test_configuration, 1);
+	const auto block = createBlock();
+
+	updateAttributeData(m, block);
+
+	REQUIRE(m.sources.size() == 2);
+	CHECK(m.sources.at(0).payload.at("data").at("x").get<double>() == 42.0);
+	CHECK(m.sources.at(0).payload.at("data").at("y").get<double>() == 12.5);
+	CHECK(m.sources.at(1).payload.at("data").at("z").get<double>() == -10.0);
+}
+
+TEST_CASE("no batch payloads without batching", "[register_map]") {
+	const auto m = createMap(test_configuration, 1);
+
+	for (const auto& source : m.sources) {
+		CHECK(source.batch.is_null());
+		CHECK(source.data == nullptr);
+		CHECK(source.timestamps == nullptr);
+	}
+
+	for (const auto& e : m.entries) {
+		CHECK(e.column == nullptr);
+	}
+}
+
+TEST_CASE("no allocations after warm-up without batching", "[register_map]") {
+	auto m = createMap(test_configuration, 1);
+	const auto block = createBlock();
+
+	updateAttributeData(m, block);
+
+	const auto before = allocations.load();
+
+	for (int i = 0; i < 10; ++i) {
+		updateAttributeData(m, block);
+	}
+
+	const auto after = allocations.load();
+
+	REQUIRE(after - before == 0);
+}
+
+TEST_CASE("no allocations after warm-up with size based batches", "[register_map]") {
+	constexpr int batch_size = 4;
+
+	auto m = createMap(test_configuration, batch_size);
+	const auto block = createBlock();
+
+	const auto cycle = [&m, &block]() {
+		for (int i = 0; i < batch_size; ++i) {
+			updateAttributeData(m, block);
+			appendToBatch(m, i);
+		}
+
+		for (auto& source : m.sources) {
+			clearBatch(source);
+		}
+	};
+
+	cycle();
+
+	const auto before = allocations.load();
+
+	for (int i = 0; i < 10; ++i) {
+		cycle();
+	}
+
+	const auto after = allocations.load();
+
+	REQUIRE(after - before == 0);
+}
+
+TEST_CASE("no allocations after warm-up with time based batches", "[register_map]") {
+	auto m = createMap(test_configuration, 1, 1000);
+	const auto block = createBlock();
+
+	REQUIRE(m.batch_capacity == 10);
+
+	for (int i = 0; i < 10; ++i) {
+		tick(m, block, i);
+	}
+
+	const auto before = allocations.load();
+
+	for (int i = 0; i < 100; ++i) {
+		tick(m, block, i);
+	}
+
+	const auto after = allocations.load();
+
+	REQUIRE(after - before == 0);
+
+	// the columns must never have grown beyond the reserved capacity
+	for (const auto& source : m.sources) {
+		for (const auto& e : source.batch.at("data")) {
+			CHECK(e.get_ref<const json::array_t&>().capacity() == m.batch_capacity);
+		}
+	}
+}
+
+TEST_CASE("time based batches are due after batch_time", "[register_map]") {
+	auto m = createMap(test_configuration, 1, 250);
+	const auto block = createBlock();
+
+	REQUIRE(m.batch_capacity == 3);
+
+	for (int i = 0; i < 2; ++i) {
+		updateAttributeData(m, block);
+		appendToBatch(m, i);
+	}
+
+	CHECK_FALSE(isBatchDue(m.sources.at(0), m.configuration));
+
+	updateAttributeData(m, block);
+	appendToBatch(m, 2);
+
+	CHECK(isBatchDue(m.sources.at(0), m.configuration));
+	CHECK(m.sources.at(0).batch.at("data").at("timestamps").size() == m.batch_capacity);
+}
+
+TEST_CASE("batch columns stay aligned", "[register_map]") {
+	const json configuration = {
+		{"map", {
+			{{"source", "a"}, {"identifier", "x"}, {"address", 1}, {"type", "u16"}},
+			{{"source", "a"}, {"identifier", "x"}, {"address", 4}, {"type", "u16"}},
+		}}
+	};
+
+	auto m = createMap(configuration, 3);
+	const auto block = createBlock();
+
+	for (int i = 0; i < 3; ++i) {
+		updateAttributeData(m, block);
+		appendToBatch(m, i);
+	}
+
+	const auto& data = m.sources.at(0).batch.at("data");
+
+	REQUIRE(m.entries.size() == 1);
+	CHECK(data.at("timestamps").size() == 3);
+	CHECK(data.at("x").size() == 3);
+	CHECK(data.at("x").at(0).get<double>() == 65535.0);
+	CHECK(isBatchDue(m.sources.at(0), m.configuration));
+}
+
+TEST_CASE("timestamps identifier is reserved when batching", "[register_map]") {
+	const json configuration = {
+		{"map", {
+			{{"source", "a"}, {"identifier", "timestamps"}, {"address", 1}, {"type", "u16"}},
+		}}
+	};
+
+	REQUIRE_THROWS_AS(createMap(configuration, 2), std::runtime_error);
+	REQUIRE_NOTHROW(createMap(configuration, 1));
+}